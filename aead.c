@@ -0,0 +1,207 @@
+#include "aead.h"
+
+#include <string.h>
+
+#ifndef HOST_BUILD
+#include "Arduino.h"
+#include "si.h"
+#endif
+
+#define SPECK_ROUNDS 27
+#define BLOCK_SIZE 8
+#define MAX_BLOCKS ((AEAD_MAX_PAYLOAD + BLOCK_SIZE - 1) / BLOCK_SIZE)
+
+// Last byte of the cipher input blocks, separating their uses.
+#define BLOCK_CTR 0x01
+#define BLOCK_MAC 0x02
+
+static uint32_t round_keys[SPECK_ROUNDS];
+static uint8_t own_id;
+static uint32_t tx_counter;
+static uint32_t rx_min_counter;
+
+// Keystream for tx_counter: block 0 masks the tag, followed by the payload
+// blocks. Valid if filled by aead_precompute() since the last aead_seal().
+static uint8_t tx_keystream[(MAX_BLOCKS + 1) * BLOCK_SIZE];
+static uint8_t tx_keystream_valid;
+
+// Keystream for the next packet expected from the peer (rx_keystream_id,
+// rx_min_counter). The peer id is learned from the last accepted packet.
+static uint8_t rx_keystream[(MAX_BLOCKS + 1) * BLOCK_SIZE];
+static uint8_t rx_keystream_valid;
+static uint8_t rx_keystream_id;
+
+// Words are little endian on air, independent of the CPU.
+static uint32_t load32(const uint8_t *p) {
+  return p[0] | ((uint16_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static void store32(uint8_t *p, uint32_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+  p[2] = v >> 16;
+  p[3] = v >> 24;
+}
+
+static void speck_encrypt(uint8_t *block) {
+  uint32_t y = load32(block);
+  uint32_t x = load32(block + 4);
+  const uint32_t *k = round_keys;
+  for (uint8_t i = 0; i < SPECK_ROUNDS; i++) {
+    x = ((x >> 8) | (x << 24)) + y;
+    x ^= *k++;
+    y = ((y << 3) | (y >> 29)) ^ x;
+  }
+  store32(block, y);
+  store32(block + 4, x);
+}
+
+static void format_block(uint8_t *block, uint8_t id, uint32_t counter,
+                         uint8_t len, uint8_t index, uint8_t type) {
+  store32(block, counter);
+  block[4] = id;
+  block[5] = len;
+  block[6] = index;
+  block[7] = type;
+}
+
+// Fills dest with the keystream blocks 0..blocks.
+static void keystream(uint8_t *dest, uint8_t id, uint32_t counter, uint8_t blocks) {
+  for (uint8_t i = 0; i <= blocks; i++) {
+    format_block(dest, id, counter, 0, i, BLOCK_CTR);
+    speck_encrypt(dest);
+    dest += BLOCK_SIZE;
+  }
+}
+
+static void cbc_mac(uint8_t *mac, uint8_t id, uint32_t counter, uint8_t len,
+                    const uint8_t *data) {
+  format_block(mac, id, counter, len, 0, BLOCK_MAC);
+  speck_encrypt(mac);
+  while (len) {
+    uint8_t n = len < BLOCK_SIZE ? len : BLOCK_SIZE;
+    for (uint8_t i = 0; i < n; i++)
+      mac[i] ^= data[i];
+    speck_encrypt(mac);
+    data += n;
+    len -= n;
+  }
+}
+
+void aead_init(const uint8_t *key, uint8_t node_id, uint32_t counter,
+               uint32_t rx_counter) {
+  uint32_t k = load32(key);
+  uint32_t l[3];
+  l[0] = load32(key + 4);
+  l[1] = load32(key + 8);
+  l[2] = load32(key + 12);
+  uint8_t j = 0;
+  for (uint8_t i = 0; i < SPECK_ROUNDS - 1; i++) {
+    round_keys[i] = k;
+    l[j] = (k + ((l[j] >> 8) | (l[j] << 24))) ^ i;
+    k = ((k << 3) | (k >> 29)) ^ l[j];
+    if (++j == 3)
+      j = 0;
+  }
+  round_keys[SPECK_ROUNDS - 1] = k;
+
+  own_id = node_id;
+  tx_counter = counter;
+  rx_min_counter = rx_counter;
+  tx_keystream_valid = 0;
+  rx_keystream_valid = 0;
+  rx_keystream_id = own_id;
+}
+
+uint32_t aead_get_tx_counter(void) {
+  return tx_counter;
+}
+
+uint32_t aead_get_rx_counter(void) {
+  return rx_min_counter;
+}
+
+void aead_precompute(void) {
+  if (!tx_keystream_valid) {
+    keystream(tx_keystream, own_id, tx_counter, MAX_BLOCKS);
+    tx_keystream_valid = 1;
+  }
+  // Until a packet was accepted, the peer id is unknown.
+  if (!rx_keystream_valid && rx_keystream_id != own_id && rx_min_counter != 0xffffffff) {
+    keystream(rx_keystream, rx_keystream_id, rx_min_counter, MAX_BLOCKS);
+    rx_keystream_valid = 1;
+  }
+}
+
+uint8_t aead_seal(uint8_t len, const uint8_t *src, uint8_t *dest) {
+  // The last counter value is reserved, so that the receiver’s replay
+  // counter can’t overflow.
+  if (tx_counter == 0xffffffff || len == 0 || len > AEAD_MAX_PAYLOAD)
+    return 0;
+  if (!tx_keystream_valid)
+    keystream(tx_keystream, own_id, tx_counter, (len + BLOCK_SIZE - 1) / BLOCK_SIZE);
+
+  dest[0] = own_id;
+  store32(dest + 1, tx_counter);
+  uint8_t *ct = dest + AEAD_HEADER_SIZE;
+  for (uint8_t i = 0; i < len; i++)
+    ct[i] = src[i] ^ tx_keystream[BLOCK_SIZE + i];
+
+  uint8_t mac[BLOCK_SIZE];
+  cbc_mac(mac, own_id, tx_counter, len, ct);
+  for (uint8_t i = 0; i < AEAD_TAG_SIZE; i++)
+    ct[len + i] = mac[i] ^ tx_keystream[i];
+
+  tx_counter++;
+  tx_keystream_valid = 0;
+  return len + AEAD_OVERHEAD;
+}
+
+uint8_t aead_open(uint8_t len, const uint8_t *src, uint8_t *dest) {
+  if (len <= AEAD_OVERHEAD || len > AEAD_MAX_PAYLOAD + AEAD_OVERHEAD)
+    return 0;
+  len -= AEAD_OVERHEAD;
+  uint8_t id = src[0];
+  uint32_t counter = load32(src + 1);
+  if (id == own_id || counter < rx_min_counter || counter == 0xffffffff)
+    return 0;
+
+  // Without a matching precomputed keystream, generate the needed blocks.
+  uint8_t blocks = (len + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  if (!rx_keystream_valid || id != rx_keystream_id || counter != rx_min_counter)
+    keystream(rx_keystream, id, counter, blocks);
+
+  // Verify before decrypting anything.
+  const uint8_t *ct = src + AEAD_HEADER_SIZE;
+  uint8_t mac[BLOCK_SIZE];
+  cbc_mac(mac, id, counter, len, ct);
+  uint8_t diff = 0;
+  for (uint8_t i = 0; i < AEAD_TAG_SIZE; i++)
+    diff |= ct[len + i] ^ mac[i] ^ rx_keystream[i];
+  rx_keystream_valid = 0;
+  if (diff)
+    return 0;
+
+  for (uint8_t i = 0; i < len; i++)
+    dest[i] = ct[i] ^ rx_keystream[BLOCK_SIZE + i];
+  rx_keystream_id = id;
+  rx_min_counter = counter + 1;
+  return len;
+}
+
+#ifndef HOST_BUILD
+static uint8_t aead_buf[AEAD_MAX_PAYLOAD + AEAD_OVERHEAD];
+
+void aead_tx(uint8_t len, const uint8_t *data) {
+  uint8_t n = aead_seal(len, data, aead_buf);
+  if (n)
+    radio_tx(n, aead_buf);
+}
+
+uint8_t aead_rx(uint8_t len, uint8_t *dest) {
+  uint8_t n = len + AEAD_OVERHEAD;
+  if (len > AEAD_MAX_PAYLOAD || radio_rx(n, aead_buf) != n)
+    return 0;
+  return aead_open(n, aead_buf, dest);
+}
+#endif
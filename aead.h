@@ -0,0 +1,64 @@
+#include <stdint.h>
+
+// Authenticated encryption for radio payloads.
+//
+// Payloads are encrypted in counter mode and authenticated with a CBC-MAC
+// over the ciphertext (CCM style), using the Speck64/128 block cipher, which
+// needs only 32bit additions, rotations and xors and no tables.
+//
+// Packet: sender id (1), counter (4, LE), ciphertext (len), tag (4)
+//
+// Each sender uses its own id and a strictly increasing counter, which serves
+// as nonce and replay protection. Packets carrying the own id (e.g. echoed by
+// a repeater) are rejected. The receiver tracks a single peer, i.e. the layer
+// is meant for point-to-point links sharing one key.
+//
+// The TX counter must never repeat for the same key and id, also not across
+// reboots: persist it (e.g. in EEPROM, reserving ranges ahead of use) and pass
+// it to aead_init(). Likewise persist the RX counter (aead_get_rx_counter())
+// and restore it with aead_init(), otherwise packets recorded before a reboot
+// of the receiver are accepted once more. With the 64bit block, rekey after
+// 2^24 packets.
+
+#define AEAD_KEY_SIZE 16
+#define AEAD_HEADER_SIZE 5
+#define AEAD_TAG_SIZE 4
+#define AEAD_OVERHEAD (AEAD_HEADER_SIZE + AEAD_TAG_SIZE)
+
+// The largest payload that fits the 64 byte radio fifo.
+#define AEAD_MAX_PAYLOAD (64 - AEAD_OVERHEAD)
+
+// Expands the key and sets the own id, the next counter to send with and the
+// lowest counter accepted from the peer.
+void aead_init(const uint8_t *key, uint8_t node_id, uint32_t tx_counter,
+               uint32_t rx_counter);
+
+// Returns the counter the next packet will be sent with.
+uint32_t aead_get_tx_counter(void);
+
+// Returns the lowest counter that will be accepted from the peer.
+uint32_t aead_get_rx_counter(void);
+
+// Precomputes the keystreams for the next aead_seal() call and for the next
+// packet expected from the peer, which leaves only the CBC-MAC on their
+// critical path. Call this while idle, e.g. before waiting for a packet.
+void aead_precompute(void);
+
+// Encrypts len bytes (1..AEAD_MAX_PAYLOAD) from src into the
+// len + AEAD_OVERHEAD bytes long packet at dest.
+// Returns the packet length, or 0 if the counter is exhausted.
+uint8_t aead_seal(uint8_t len, const uint8_t *src, uint8_t *dest);
+
+// Authenticates and decrypts a len bytes long packet from src into dest
+// (len - AEAD_OVERHEAD bytes). Returns the payload length, or 0 if the packet
+// is forged, corrupted, replayed or was sent by this node.
+uint8_t aead_open(uint8_t len, const uint8_t *src, uint8_t *dest);
+
+#ifndef HOST_BUILD
+// Encrypts and submits a payload of len bytes.
+void aead_tx(uint8_t len, const uint8_t *data);
+
+// Receives a packet sent with aead_tx(len, …) and decrypts it.
+// Blocks like radio_rx(). Returns 0 if the packet was rejected.
+uint8_t aead_rx(uint8_t len, uint8_t *dest);
+#endif
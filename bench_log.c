@@ -0,0 +1,33 @@
+#include "bench_log.h"
+
+#include <stdio.h>
+
+extern void swimcat_flush(void);
+
+static void put_dec(uint32_t n) {
+  char buf[10];
+  uint8_t i = 0;
+  do {
+    buf[i++] = '0' + n % 10;
+    n /= 10;
+  } while (n);
+  while (i)
+    putchar(buf[--i]);
+}
+
+void bench_log_start(char type, const char *name) {
+  putchar(type);
+  putchar(',');
+  while (*name)
+    putchar(*name++);
+}
+
+void bench_log_value(uint32_t n) {
+  putchar(',');
+  put_dec(n);
+}
+
+void bench_log_end(void) {
+  puts("\r");
+  swimcat_flush();
+}
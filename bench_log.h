@@ -0,0 +1,13 @@
+#include <stdint.h>
+
+// Result lines of the benchmark targets, `<type>,<name>,<value>,…`, as parsed
+// by tools/bench_report.py. Linked automatically for TARGET=*_bench.
+
+// Starts a line with the record type (e.g. 'B') and the test name.
+void bench_log_start(char type, const char *name);
+
+// Appends `,<n>`.
+void bench_log_value(uint32_t n);
+
+// Ends the line and flushes the console.
+void bench_log_end(void);
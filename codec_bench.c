@@ -0,0 +1,222 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "Arduino.h"
+#include "bench_log.h"
+#include "stm8.h"
+#include "hc12.h"
+
+#include "aead.h"
+#include "fec.h"
+#include "lz.h"
+
+// Times the payload codecs on the STM8, no radio needed.
+// Build it for one codec at a time, e.g. `make TARGET=codec_bench MODULES=aead
+// flash`: with all of them linked, their buffers leave too little of the 1kB
+// RAM for the stack. Only the codecs in MODULES are timed.
+//
+// Each operation is timed on its own with TIM2, CODEC_ITERATIONS times, and
+// logged as `C,<op>,<payload_len>,<packet_len>,<iterations>,<cycles>` lines
+// with the summed CPU cycles, which tools/bench_report.py compares against
+// the packet airtime.
+
+#define CODEC_ITERATIONS 200
+
+// TIM2 counts CPU cycles / 2^CODEC_TIMER_PRESCALER, which covers operations
+// of up to 262144 cycles (16ms at 16MHz). Longer ones saturate.
+#define CODEC_TIMER_PRESCALER 2
+
+#ifndef TIM2_CR1
+#define TIM2_CR1 (*(volatile uint8_t *) 0x5300)
+#define TIM2_SR1 (*(volatile uint8_t *) 0x5304)
+#define TIM2_EGR (*(volatile uint8_t *) 0x5306)
+#define TIM2_CNTRH (*(volatile uint8_t *) 0x530c)
+#define TIM2_CNTRL (*(volatile uint8_t *) 0x530d)
+#define TIM2_PSCR (*(volatile uint8_t *) 0x530e)
+#endif
+
+extern void swimcat_flush(void);
+
+#if !defined(MODULE_FEC) && !defined(MODULE_LZ) && !defined(MODULE_AEAD)
+#error "set MODULES to the codec to time, e.g. MODULES=fec"
+#endif
+
+// The payload of all codecs, kept in flash.
+static const char sample[] = "INFO node=3 seq=17 temp=21.5 hum=40 ok\r\nINFO node=3 seq=18";
+
+static uint8_t packet[64];
+static uint8_t decoded[64];
+#ifdef MODULE_AEAD
+// A second packet, sealed with the keystream from aead_precompute().
+static uint8_t packet_precomputed[64];
+#endif
+
+// Timer ticks of an empty measurement, subtracted from all others.
+static uint16_t timer_overhead;
+
+static void timer_init(void) {
+  TIM2_PSCR = CODEC_TIMER_PRESCALER;
+  TIM2_EGR = 0x01;  // UG: load the prescaler
+  TIM2_CR1 = 0x01;  // CEN
+}
+
+static void timer_start(void) {
+  TIM2_CNTRH = 0;
+  TIM2_CNTRL = 0;
+  TIM2_SR1 = 0;  // clear UIF
+}
+
+// Returns the cycles since timer_start().
+static uint32_t timer_cycles(void) {
+  // Reading the high byte latches the low byte.
+  uint16_t ticks = (uint16_t) TIM2_CNTRH << 8;
+  ticks |= TIM2_CNTRL;
+  if (TIM2_SR1 & 0x01)  // UIF: the counter wrapped
+    ticks = 0xffff;
+  else if (ticks > timer_overhead)
+    ticks -= timer_overhead;
+  else
+    ticks = 0;
+  return (uint32_t) ticks << CODEC_TIMER_PRESCALER;
+}
+
+static void report(const char *op, uint8_t len, uint8_t packet_len, uint32_t cycles) {
+  bench_log_start('C', op);
+  bench_log_value(len);
+  bench_log_value(packet_len);
+  bench_log_value(CODEC_ITERATIONS);
+  bench_log_value(cycles);
+  bench_log_end();
+}
+
+#ifdef MODULE_FEC
+static void bench_fec(uint8_t len) {
+  uint8_t n = 0;
+  uint32_t encode = 0;
+  uint32_t decode = 0;
+  for (uint16_t i = 0; i < CODEC_ITERATIONS; i++) {
+    timer_start();
+    n = fec_encode(len, (const uint8_t *) sample, packet);
+    encode += timer_cycles();
+
+    timer_start();
+    fec_decode(n, packet, decoded);
+    decode += timer_cycles();
+  }
+  report("fec_encode", len, n, encode);
+  report("fec_decode", len, n, decode);
+}
+#endif
+
+#ifdef MODULE_LZ
+static void bench_lz(uint8_t len) {
+  uint8_t n = 0;
+  uint32_t compress = 0;
+  uint32_t decompress = 0;
+  for (uint16_t i = 0; i < CODEC_ITERATIONS; i++) {
+    timer_start();
+    n = lz_compress(len, (const uint8_t *) sample, packet);
+    compress += timer_cycles();
+
+    timer_start();
+    lz_decompress(n, packet, decoded, sizeof(decoded));
+    decompress += timer_cycles();
+  }
+  report("lz_compress", len, n, compress);
+  report("lz_decompress", len, n, decompress);
+}
+#endif
+
+#ifdef MODULE_AEAD
+
+static const uint8_t aead_key[AEAD_KEY_SIZE] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+};
+
+// aead_seal() and aead_open() with and without a keystream from
+// aead_precompute(), and aead_precompute() itself, which runs while idle.
+// Each round seals two packets as node 1 and opens them as node 2.
+static void bench_aead(uint8_t len) {
+  const uint8_t *src = (const uint8_t *) sample;
+  uint8_t n = 0;
+  uint8_t failed = 0;
+  uint32_t seal = 0;
+  uint32_t precompute_tx = 0;
+  uint32_t seal_precomputed = 0;
+  uint32_t open = 0;
+  uint32_t precompute_rx = 0;
+  uint32_t open_precomputed = 0;
+  for (uint16_t i = 0; i < CODEC_ITERATIONS; i++) {
+    aead_init(aead_key, 1, 2 * i, 0);
+    timer_start();
+    n = aead_seal(len, src, packet);
+    seal += timer_cycles();
+
+    // The peer is unknown, so this only covers the TX keystream.
+    timer_start();
+    aead_precompute();
+    precompute_tx += timer_cycles();
+
+    timer_start();
+    aead_seal(len, src, packet_precomputed);
+    seal_precomputed += timer_cycles();
+
+    // Precompute the receiver’s TX keystream outside of the measurements.
+    aead_init(aead_key, 2, 0, 2 * i);
+    aead_precompute();
+
+    timer_start();
+    failed |= aead_open(n, packet, decoded) != len;
+    open += timer_cycles();
+
+    // The first packet taught the receiver the peer id, this only covers the
+    // RX keystream.
+    timer_start();
+    aead_precompute();
+    precompute_rx += timer_cycles();
+
+    timer_start();
+    failed |= aead_open(n, packet_precomputed, decoded) != len;
+    open_precomputed += timer_cycles();
+  }
+  if (failed) {
+    puts("aead_open failed\r");
+    return;
+  }
+  report("aead_seal", len, n, seal);
+  report("aead_precompute_tx", len, n, precompute_tx);
+  report("aead_seal_precomputed", len, n, seal_precomputed);
+  report("aead_open", len, n, open);
+  report("aead_precompute_rx", len, n, precompute_rx);
+  report("aead_open_precomputed", len, n, open_precomputed);
+}
+#endif
+
+void setup(void) {
+  puts("HC12 codec bench\r");
+
+  timer_init();
+  timer_start();
+  timer_overhead = 0;
+  timer_overhead = timer_cycles() >> CODEC_TIMER_PRESCALER;
+
+#ifdef MODULE_FEC
+  bench_fec(HC12_PACKET_SIZE_15KBS - 1);
+  bench_fec(FEC_MAX_PAYLOAD);
+#endif
+#ifdef MODULE_LZ
+  lz_init(NULL, 0);
+  bench_lz(HC12_PACKET_SIZE_15KBS - 1);
+  bench_lz(sizeof(sample) - 1);
+#endif
+#ifdef MODULE_AEAD
+  bench_aead(HC12_PACKET_SIZE_15KBS - AEAD_OVERHEAD);
+  bench_aead(HC12_PACKET_SIZE_236KBS - AEAD_OVERHEAD);
+#endif
+  puts("C,end\r");
+}
+
+void loop(void) {
+  swimcat_flush();
+}
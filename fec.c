@@ -0,0 +1,144 @@
+#include "fec.h"
+
+#include <string.h>
+
+#ifndef HOST_BUILD
+#include "Arduino.h"
+#include "si.h"
+#endif
+
+// Codeword for each nibble: data in bits 0-3, parity in bits 4-7.
+static const uint8_t hamming_encode[16] = {
+  0x00, 0xb1, 0xd2, 0x63, 0xe4, 0x55, 0x36, 0x87,
+  0x78, 0xc9, 0xaa, 0x1b, 0x9c, 0x2d, 0x4e, 0xff,
+};
+
+// Nibble for each received byte. 0x40: one bit was corrected.
+// 0x80: uncorrectable (two bit errors).
+static const uint8_t hamming_decode[256] = {
+  0x00, 0x40, 0x40, 0x80, 0x40, 0x80, 0x80, 0x47, 0x40, 0x80, 0x80, 0x4b, 0x80, 0x4d, 0x4e, 0x80,
+  0x40, 0x80, 0x80, 0x4b, 0x80, 0x45, 0x46, 0x80, 0x80, 0x4b, 0x4b, 0x0b, 0x4c, 0x80, 0x80, 0x4b,
+  0x40, 0x80, 0x80, 0x43, 0x80, 0x4d, 0x46, 0x80, 0x80, 0x4d, 0x4a, 0x80, 0x4d, 0x0d, 0x80, 0x4d,
+  0x80, 0x41, 0x46, 0x80, 0x46, 0x80, 0x06, 0x46, 0x48, 0x80, 0x80, 0x4b, 0x80, 0x4d, 0x46, 0x80,
+  0x40, 0x80, 0x80, 0x43, 0x80, 0x45, 0x4e, 0x80, 0x80, 0x49, 0x4e, 0x80, 0x4e, 0x80, 0x0e, 0x4e,
+  0x80, 0x45, 0x42, 0x80, 0x45, 0x05, 0x80, 0x45, 0x48, 0x80, 0x80, 0x4b, 0x80, 0x45, 0x4e, 0x80,
+  0x80, 0x43, 0x43, 0x03, 0x44, 0x80, 0x80, 0x43, 0x48, 0x80, 0x80, 0x43, 0x80, 0x4d, 0x4e, 0x80,
+  0x48, 0x80, 0x80, 0x43, 0x80, 0x45, 0x46, 0x80, 0x08, 0x48, 0x48, 0x80, 0x48, 0x80, 0x80, 0x4f,
+  0x40, 0x80, 0x80, 0x47, 0x80, 0x47, 0x47, 0x07, 0x80, 0x49, 0x4a, 0x80, 0x4c, 0x80, 0x80, 0x47,
+  0x80, 0x41, 0x42, 0x80, 0x4c, 0x80, 0x80, 0x47, 0x4c, 0x80, 0x80, 0x4b, 0x0c, 0x4c, 0x4c, 0x80,
+  0x80, 0x41, 0x4a, 0x80, 0x44, 0x80, 0x80, 0x47, 0x4a, 0x80, 0x0a, 0x4a, 0x80, 0x4d, 0x4a, 0x80,
+  0x41, 0x01, 0x80, 0x41, 0x80, 0x41, 0x46, 0x80, 0x80, 0x41, 0x4a, 0x80, 0x4c, 0x80, 0x80, 0x4f,
+  0x80, 0x49, 0x42, 0x80, 0x44, 0x80, 0x80, 0x47, 0x49, 0x09, 0x80, 0x49, 0x80, 0x49, 0x4e, 0x80,
+  0x42, 0x80, 0x02, 0x42, 0x80, 0x45, 0x42, 0x80, 0x80, 0x49, 0x42, 0x80, 0x4c, 0x80, 0x80, 0x4f,
+  0x44, 0x80, 0x80, 0x43, 0x04, 0x44, 0x44, 0x80, 0x80, 0x49, 0x4a, 0x80, 0x44, 0x80, 0x80, 0x4f,
+  0x80, 0x41, 0x42, 0x80, 0x44, 0x80, 0x80, 0x4f, 0x48, 0x80, 0x80, 0x4f, 0x80, 0x4f, 0x4f, 0x0f,
+};
+
+// CRC8 remainder of each nibble, a 16 entry table is a good tradeoff
+// between speed and flash size on the STM8.
+static const uint8_t crc8_nibble[16] = {
+  0x00, 0x07, 0x0e, 0x09, 0x1c, 0x1b, 0x12, 0x15,
+  0x38, 0x3f, 0x36, 0x31, 0x24, 0x23, 0x2a, 0x2d,
+};
+
+uint8_t fec_crc8(uint8_t crc, uint8_t len, const uint8_t *data) {
+  while (len--) {
+    crc ^= *data++;
+    crc = (crc << 4) ^ crc8_nibble[crc >> 4];
+    crc = (crc << 4) ^ crc8_nibble[crc >> 4];
+  }
+  return crc;
+}
+
+// Codewords of the packet being encoded or decoded, before interleaving.
+static uint8_t codewords[FEC_ENCODED_SIZE(FEC_MAX_PAYLOAD)];
+
+// Walks the on-air bits in order, which keeps the loops free of 16bit bit
+// positions and variable shifts: on-air bit k is bit k / n of codeword k % n.
+
+uint8_t fec_encode(uint8_t len, const uint8_t *src, uint8_t *dest) {
+  if (len == 0 || len > FEC_MAX_PAYLOAD)
+    return 0;
+  uint8_t n = FEC_ENCODED_SIZE(len);
+  uint8_t crc = fec_crc8(0xff, len, src);
+  uint8_t *cw = codewords;
+  for (uint8_t i = 0; i <= len; i++) {
+    uint8_t c = i < len ? src[i] : crc;
+    *cw++ = hamming_encode[c & 0xf];
+    *cw++ = hamming_encode[c >> 4];
+  }
+
+  uint8_t ci = 0;
+  uint8_t plane = 1;
+  for (uint8_t k = 0; k < n; k++) {
+    uint8_t byte = 0;
+    for (uint8_t mask = 1; mask; mask <<= 1) {
+      if (codewords[ci] & plane)
+        byte |= mask;
+      if (++ci == n) {
+        ci = 0;
+        plane <<= 1;
+      }
+    }
+    dest[k] = byte;
+  }
+  return n;
+}
+
+uint8_t fec_decode(uint8_t len, const uint8_t *src, uint8_t *dest) {
+  uint8_t n = len & ~1;
+  if (n == 0 || n > sizeof(codewords))
+    return 0;
+  memset(codewords, 0, n);
+  uint8_t ci = 0;
+  uint8_t plane = 1;
+  for (uint8_t k = 0; k < n; k++) {
+    uint8_t byte = src[k];
+    for (uint8_t mask = 1; mask; mask <<= 1) {
+      if (byte & mask)
+        codewords[ci] |= plane;
+      if (++ci == n) {
+        ci = 0;
+        plane <<= 1;
+      }
+    }
+  }
+
+  len = n / 2;
+  uint8_t errors = 0;
+  const uint8_t *cw = codewords;
+  for (uint8_t i = 0; i < len; i++) {
+    uint8_t lo_n = hamming_decode[*cw++];
+    uint8_t hi_n = hamming_decode[*cw++];
+    errors |= lo_n | hi_n;
+    dest[i] = (lo_n & 0xf) | (hi_n << 4);
+  }
+  if (errors & 0x80)
+    return 0;
+  // The CRC checksums the payload including itself, which yields 0 if intact.
+  if (fec_crc8(0xff, len, dest) != 0)
+    return 0;
+  return len - 1;
+}
+
+#ifndef HOST_BUILD
+static uint8_t fec_buf[FEC_ENCODED_SIZE(FEC_MAX_PAYLOAD)];
+
+uint8_t fec_tx(uint8_t len, const uint8_t *data) {
+  uint8_t n = fec_encode(len, data, fec_buf);
+  if (n)
+    radio_tx(n, fec_buf);
+  return n;
+}
+
+uint8_t fec_rx(uint8_t len, uint8_t *dest) {
+  uint8_t status;
+  if (len == 0 || len > FEC_MAX_PAYLOAD)
+    return 0;
+  // The radio CRC status is ignored, fec_decode() checks the corrected data.
+  uint8_t recvd = radio_rx_raw(FEC_ENCODED_SIZE(len), fec_buf, &status);
+  if (recvd != FEC_ENCODED_SIZE(len))
+    return 0;
+  return fec_decode(recvd, fec_buf, dest);
+}
+#endif
@@ -0,0 +1,45 @@
+#include <stdint.h>
+
+// Forward error correction for radio payloads.
+//
+// Each byte of the payload (plus a trailing CRC8) is split into two nibbles
+// that are encoded as extended Hamming(8,4) codewords, which corrects one and
+// detects two bit errors per codeword. The codewords are bit interleaved over
+// the whole packet: on air, bit 0 of all codewords comes first, then bit 1 and
+// so on. A burst of up to FEC_ENCODED_SIZE(len) bits thus becomes single bit
+// errors in different codewords, which are all corrected.
+//
+// The radio CRC is ignored on receive, instead the payload is checked with a
+// software CRC after correction.
+
+// Size of the encoded packet for a payload of len bytes.
+#define FEC_ENCODED_SIZE(len) (2 * ((len) + 1))
+
+// The largest payload that fits the 64 byte radio fifo.
+#define FEC_MAX_PAYLOAD 31
+
+// ITU-T CRC8 (poly 0x07), as used by the radio, starting with crc=0xff.
+uint8_t fec_crc8(uint8_t crc, uint8_t len, const uint8_t *data);
+
+// Encodes len bytes (1 to FEC_MAX_PAYLOAD) from src to FEC_ENCODED_SIZE(len)
+// bytes in dest. Returns the encoded size, or 0 if len is out of range.
+uint8_t fec_encode(uint8_t len, const uint8_t *src, uint8_t *dest);
+
+// Decodes len encoded bytes from src to dest.
+// Returns the payload length (len / 2 - 1), or 0 if the data could not be
+// corrected. dest must be len / 2 bytes long to also hold the CRC.
+// src and dest may not overlap.
+uint8_t fec_decode(uint8_t len, const uint8_t *src, uint8_t *dest);
+
+#ifndef HOST_BUILD
+// Encodes and submits a payload of len bytes (1 to FEC_MAX_PAYLOAD).
+// Returns the encoded size, or 0 if nothing was sent because len is out of
+// range.
+uint8_t fec_tx(uint8_t len, const uint8_t *data);
+
+// Receives and decodes a packet sent with fec_tx(len, …).
+// Blocks like radio_rx(). Returns 0 if len is out of range or the packet
+// could not be corrected.
+// dest must be len + 1 bytes long.
+uint8_t fec_rx(uint8_t len, uint8_t *dest);
+#endif
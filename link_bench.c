@@ -0,0 +1,258 @@
+#include <stdint.h>
+#include <stdio.h>
+
+#include "Arduino.h"
+#include "bench_log.h"
+#include "si.h"
+#include "stm8.h"
+#include "hc12.h"
+
+// Link benchmark: measures ping-pong latency, unidirectional throughput and
+// packet error rate vs TX power for all modem profiles between two devices.
+//
+// Flash this to two devices. The one with SET pulled low at boot becomes the
+// initiator, the other one the responder. The initiator logs its results as
+// `B,…` lines (see tools/bench_report.py) to the console.
+//
+// Each measurement is negotiated on the control profile (HC12 default
+// 15kbit), then both devices switch to the profile under test. The responder
+// falls back to the control profile after BENCH_IDLE_MS without packets.
+
+#define BENCH_MAGIC 'b'
+#define CMD_START_PING 1
+#define CMD_START_TPUT 2
+#define CMD_ACK 3
+#define CMD_PING 4
+#define CMD_DATA 5
+#define CMD_DONE 6
+#define CMD_QUERY 7
+#define CMD_REPORT 8
+
+// Packet layout, every packet is at least HC12_PACKET_SIZE_5KBS long.
+#define PKT_MAGIC 0
+#define PKT_CMD 1
+#define PKT_PROFILE 2
+#define PKT_POWER 3
+#define PKT_SEQ 4  // 16bit LE, sequence number or packet count
+
+#define CONTROL_PROFILE 1
+#define CONTROL_POWER 40
+#define CONTROL_RETRIES 10
+#define CONTROL_TIMEOUT_MS 300
+
+#define PING_COUNT 50
+#define PING_TIMEOUT_MS 250
+#define TPUT_COUNT 200
+#define BENCH_IDLE_MS 1500
+
+struct profile {
+  const uint8_t *config;
+  uint8_t packet_size;
+  uint8_t kbit;
+};
+
+static const struct profile profiles[] = {
+  {si_config_5kbit, HC12_PACKET_SIZE_5KBS, 5},
+  {si_config_15kbit, HC12_PACKET_SIZE_15KBS, 15},
+  {si_config_58kbit, HC12_PACKET_SIZE_58KBS, 58},
+  {si_config_236kbit, HC12_PACKET_SIZE_236KBS, 236},
+};
+#define NUM_PROFILES (sizeof(profiles) / sizeof(*profiles))
+
+// TX power levels for the PER sweep.
+static const uint8_t powers[] = {4, 9, 18, 40, 127};
+
+static uint8_t tx_buf[HC12_PACKET_SIZE_236KBS];
+static uint8_t rx_buf[HC12_PACKET_SIZE_236KBS];
+static uint8_t is_initiator;
+
+extern void swimcat_flush(void);
+
+void on_portC(void) {  // IO1 / IRQ
+  if (digitalRead(SI_IRQ) == 0) {
+    si_notify_nirq();
+  }
+}
+
+// Prints a result line: B,<name>,<kbit>,<power>,<len>,<sent>,<received>,<ms>
+static void report(const char *name, uint8_t p, uint8_t power, uint16_t sent,
+                   uint16_t received, uint32_t ms) {
+  bench_log_start('B', name);
+  bench_log_value(profiles[p].kbit);
+  bench_log_value(power);
+  bench_log_value(profiles[p].packet_size);
+  bench_log_value(sent);
+  bench_log_value(received);
+  bench_log_value(ms);
+  bench_log_end();
+}
+
+static void use_profile(uint8_t p, uint8_t power) {
+  si_radio_config(profiles[p].config);
+  si_set_tx_power(power);
+  si_clear_fifo();
+  si_start_rx(profiles[p].packet_size);
+}
+
+static void send(uint8_t p, uint8_t cmd, uint8_t arg_profile, uint8_t power, uint16_t seq) {
+  tx_buf[PKT_MAGIC] = BENCH_MAGIC;
+  tx_buf[PKT_CMD] = cmd;
+  tx_buf[PKT_PROFILE] = arg_profile;
+  tx_buf[PKT_POWER] = power;
+  tx_buf[PKT_SEQ] = seq;
+  tx_buf[PKT_SEQ + 1] = seq >> 8;
+  radio_tx(profiles[p].packet_size, tx_buf);
+}
+
+static uint16_t rx_seq(void) {
+  return rx_buf[PKT_SEQ] | (rx_buf[PKT_SEQ + 1] << 8);
+}
+
+// Waits up to timeout_ms for a benchmark packet on profile p.
+// Returns its command, or 0 on timeout.
+static uint8_t receive(uint8_t p, uint16_t timeout_ms) {
+  uint8_t len = profiles[p].packet_size;
+  uint32_t start = millis();
+  for (;;) {
+    if (si_get_state() != SI_STATE_RX) {
+      si_clear_fifo();
+      si_start_rx(len);
+    }
+    // NIRQ stays low while an interrupt is pending.
+    while (digitalRead(SI_IRQ)) {
+      if (millis() - start >= timeout_ms)
+        return 0;
+    }
+    if (radio_rx(len, rx_buf) == len && rx_buf[PKT_MAGIC] == BENCH_MAGIC)
+      return rx_buf[PKT_CMD];
+    if (millis() - start >= timeout_ms)
+      return 0;
+  }
+}
+
+// Sends a control command until it is answered with the expected reply.
+static uint8_t control(uint8_t cmd, uint8_t p, uint8_t power, uint8_t reply) {
+  for (uint8_t i = 0; i < CONTROL_RETRIES; i++) {
+    send(CONTROL_PROFILE, cmd, p, power, 0);
+    if (receive(CONTROL_PROFILE, CONTROL_TIMEOUT_MS) == reply)
+      return 1;
+  }
+  return 0;
+}
+
+static void finish_phase(uint8_t p) {
+  for (uint8_t i = 0; i < 3; i++)
+    send(p, CMD_DONE, p, 0, 0);
+  use_profile(CONTROL_PROFILE, CONTROL_POWER);
+}
+
+// Initiator: round trips of PING_COUNT packets on profile p.
+static void bench_ping(uint8_t p, uint8_t power) {
+  if (!control(CMD_START_PING, p, power, CMD_ACK)) {
+    puts("no responder\r");
+    return;
+  }
+  use_profile(p, power);
+  uint16_t received = 0;
+  uint32_t total_ms = 0;
+  for (uint16_t seq = 0; seq < PING_COUNT; seq++) {
+    uint32_t start = millis();
+    send(p, CMD_PING, p, power, seq);
+    if (receive(p, PING_TIMEOUT_MS) == CMD_PING && rx_seq() == seq) {
+      total_ms += millis() - start;
+      received++;
+    }
+  }
+  finish_phase(p);
+
+  report("ping", p, power, PING_COUNT, received, total_ms);
+}
+
+// Initiator: TPUT_COUNT back-to-back packets on profile p.
+static void bench_tput(uint8_t p, uint8_t power) {
+  if (!control(CMD_START_TPUT, p, power, CMD_ACK)) {
+    puts("no responder\r");
+    return;
+  }
+  use_profile(p, power);
+  uint32_t start = millis();
+  for (uint16_t seq = 0; seq < TPUT_COUNT; seq++)
+    send(p, CMD_DATA, p, power, seq);
+  uint32_t elapsed_ms = millis() - start;
+  finish_phase(p);
+
+  if (!control(CMD_QUERY, p, power, CMD_REPORT)) {
+    puts("no report\r");
+    return;
+  }
+  report("tput", p, power, TPUT_COUNT, rx_seq(), elapsed_ms);
+}
+
+// Responder: serves one phase on profile p, returns the number of
+// data packets received.
+static uint16_t serve_phase(uint8_t p, uint8_t power) {
+  uint16_t count = 0;
+  use_profile(p, power);
+  for (;;) {
+    uint8_t cmd = receive(p, BENCH_IDLE_MS);
+    if (cmd == CMD_PING) {
+      // rx_buf is echoed as is.
+      radio_tx(profiles[p].packet_size, rx_buf);
+    } else if (cmd == CMD_DATA) {
+      count++;
+    } else if (cmd == CMD_DONE || cmd == 0) {
+      break;
+    }
+  }
+  use_profile(CONTROL_PROFILE, CONTROL_POWER);
+  return count;
+}
+
+static void responder(void) {
+  static uint16_t last_count;
+  uint8_t cmd = receive(CONTROL_PROFILE, BENCH_IDLE_MS);
+  uint8_t p = rx_buf[PKT_PROFILE];
+  uint8_t power = rx_buf[PKT_POWER];
+  if (cmd == CMD_START_PING || cmd == CMD_START_TPUT) {
+    if (p >= NUM_PROFILES)
+      return;
+    send(CONTROL_PROFILE, CMD_ACK, p, power, 0);
+    last_count = serve_phase(p, power);
+  } else if (cmd == CMD_QUERY) {
+    send(CONTROL_PROFILE, CMD_REPORT, p, power, last_count);
+  }
+}
+
+static void initiator(void) {
+  for (uint8_t p = 0; p < NUM_PROFILES; p++) {
+    bench_ping(p, CONTROL_POWER);
+    for (uint8_t i = 0; i < sizeof(powers); i++)
+      bench_tput(p, powers[i]);
+  }
+  puts("B,end\r");
+  swimcat_flush();
+}
+
+void setup(void) {
+  puts("HC12 bench\r");
+
+  pinMode(HC12_SET, INPUT_PULLUP);
+  is_initiator = !digitalRead(HC12_SET);
+
+  // C4 (IRQ): Low while a radio interrupt is pending.
+  attachInterrupt(SI_IRQ, &on_portC, FALLING); // C4
+
+  if (!radio_init(profiles[CONTROL_PROFILE].config))
+    return;
+  for (uint8_t i = 0; i < sizeof(tx_buf); i++)
+    tx_buf[i] = ' ';
+  use_profile(CONTROL_PROFILE, CONTROL_POWER);
+}
+
+void loop(void) {
+  swimcat_flush();
+  if (is_initiator)
+    initiator();
+  else
+    responder();
+}
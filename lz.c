@@ -0,0 +1,162 @@
+#include "lz.h"
+
+#include <string.h>
+
+#ifndef HOST_BUILD
+#include "Arduino.h"
+#include "si.h"
+#endif
+
+// The hash tables map 3 bytes to the last window position they were seen at.
+// Candidates are verified, so neither collisions nor stale entries matter.
+#define LZ_HASH_SIZE 64
+
+static const uint8_t *lz_dict;
+static uint8_t lz_dict_len;
+static uint8_t dict_heads[LZ_HASH_SIZE];
+static uint8_t heads[LZ_HASH_SIZE];
+
+static uint8_t lz_hash(const uint8_t *p) {
+  return ((p[0] << 3) ^ (p[1] << 1) ^ p[2] ^ (p[0] >> 3)) & (LZ_HASH_SIZE - 1);
+}
+
+void lz_init(const uint8_t *dict, uint8_t dict_len) {
+  if (dict_len > LZ_MAX_DICT)
+    dict_len = LZ_MAX_DICT;
+  lz_dict = dict;
+  lz_dict_len = dict_len;
+  memset(dict_heads, 0, sizeof(dict_heads));
+  for (uint8_t i = 0; i + LZ_MIN_MATCH <= dict_len; i++)
+    dict_heads[lz_hash(dict + i)] = i;
+}
+
+// Returns the byte at window position pos, with data holding the packet.
+static uint8_t lz_window(const uint8_t *data, uint8_t pos) {
+  return pos < lz_dict_len ? lz_dict[pos] : data[pos - lz_dict_len];
+}
+
+uint8_t lz_compress(uint8_t len, const uint8_t *src, uint8_t *dest) {
+  if (len > LZ_MAX_PACKET)
+    return 0;
+  memcpy(heads, dict_heads, sizeof(heads));
+
+  uint8_t o = 1;
+  uint8_t flag_pos = 0;
+  uint8_t flag_bit = 0;
+  uint8_t i = 0;
+  dest[0] = LZ_COMPRESSED | len;
+  while (i < len) {
+    // Stop as soon as the output can’t get smaller than raw storage anymore.
+    if (o + 3 > len + 1)
+      goto raw;
+    if (flag_bit == 0) {
+      flag_pos = o++;
+      dest[flag_pos] = 0;
+      flag_bit = 1;
+    }
+
+    uint8_t match_len = 0;
+    uint8_t cand = 0;
+    uint8_t remaining = len - i;
+    if (remaining >= LZ_MIN_MATCH) {
+      uint8_t h = lz_hash(src + i);
+      cand = heads[h];
+      heads[h] = lz_dict_len + i;
+      // The match may run into the current position, which the decoder
+      // handles by copying byte by byte.
+      if (cand < lz_dict_len + i) {
+        while (match_len < remaining &&
+               lz_window(src, cand + match_len) == src[i + match_len])
+          match_len++;
+      }
+    }
+
+    if (match_len >= LZ_MIN_MATCH) {
+      dest[flag_pos] |= flag_bit;
+      dest[o++] = cand;
+      dest[o++] = match_len - LZ_MIN_MATCH;
+      // Index the skipped positions for later matches.
+      for (uint8_t j = i + 1; j < i + match_len && j + LZ_MIN_MATCH <= len; j++)
+        heads[lz_hash(src + j)] = lz_dict_len + j;
+      i += match_len;
+    } else {
+      dest[o++] = src[i++];
+    }
+    flag_bit <<= 1;
+  }
+  return o;
+
+raw:
+  dest[0] = len;
+  memcpy(dest + 1, src, len);
+  return len + 1;
+}
+
+uint8_t lz_decompress(uint8_t len, const uint8_t *src, uint8_t *dest, uint8_t max) {
+  if (len == 0)
+    return 0;
+  if (max > LZ_MAX_PACKET)
+    max = LZ_MAX_PACKET;
+  uint8_t out_len = src[0] & ~LZ_COMPRESSED;
+  if (out_len > max)
+    return 0;
+  if (!(src[0] & LZ_COMPRESSED)) {
+    if (len - 1 < out_len)
+      return 0;
+    memcpy(dest, src + 1, out_len);
+    return out_len;
+  }
+
+  uint8_t i = 1;
+  uint8_t o = 0;
+  uint8_t flags = 0;
+  uint8_t flag_bit = 0;
+  while (o < out_len) {
+    if (i >= len)
+      return 0;
+    if (flag_bit == 0) {
+      flags = src[i++];
+      flag_bit = 1;
+      continue;
+    }
+    if (flags & flag_bit) {
+      if (i + 2 > len)
+        return 0;
+      uint8_t pos = src[i];
+      uint8_t n = src[i + 1] + LZ_MIN_MATCH;
+      i += 2;
+      if (n > out_len - o || pos >= lz_dict_len + o)
+        return 0;
+      while (n--)
+        dest[o++] = lz_window(dest, pos++);
+    } else {
+      dest[o++] = src[i++];
+    }
+    flag_bit <<= 1;
+  }
+  return o;
+}
+
+#ifndef HOST_BUILD
+// Compressed packet, on receive preceded by the radio length byte.
+static uint8_t lz_buf[1 + LZ_MAX_TX_PAYLOAD + 1];
+
+uint8_t lz_tx(uint8_t len, const uint8_t *data) {
+  if (len > LZ_MAX_TX_PAYLOAD)
+    return 0;
+  uint8_t n = lz_compress(len, data, lz_buf);
+  // Pad up to the shortest packet the modem config can express, decoding
+  // stops at the original length.
+  uint8_t min_len = radio_tx_variable_min_len();
+  while (n < min_len)
+    lz_buf[n++] = 0;
+  return radio_tx_variable(n, lz_buf);
+}
+
+uint8_t lz_rx(uint8_t max, uint8_t *dest) {
+  uint8_t n = radio_rx_variable(sizeof(lz_buf), lz_buf);
+  if (n < 2)
+    return 0;
+  return lz_decompress(n - 1, lz_buf + 1, dest, max);
+}
+#endif
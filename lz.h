@@ -0,0 +1,54 @@
+#include <stdint.h>
+
+// Lightweight LZ compression for radio payloads.
+//
+// Each packet is compressed on its own, so that a lost packet doesn’t affect
+// the following ones. To still find matches in short packets, the window is
+// primed with a static dictionary of strings typical for the application
+// (e.g. log prefixes or record headers) that must be the same on both ends.
+//
+// Format: a header byte holding the original length and the LZ_COMPRESSED
+// flag, followed by the raw data or by groups of a flag byte and 8 items.
+// Flag bit i (LSB first) set means item i is a match (window position,
+// length - LZ_MIN_MATCH), otherwise it is a literal byte. The window is the
+// dictionary followed by the packet. Decoding stops at the original length,
+// so padding (e.g. of fixed size packets) is ignored.
+
+#define LZ_COMPRESSED 0x80
+
+#define LZ_MIN_MATCH 3
+
+// Dictionary and packet need to fit into the 256 byte window.
+#define LZ_MAX_DICT 192
+#define LZ_MAX_PACKET 64
+
+// Sets the dictionary (may be NULL / 0). dict needs to stay valid.
+void lz_init(const uint8_t *dict, uint8_t dict_len);
+
+// Compresses len bytes (up to LZ_MAX_PACKET) from src into dest, which must be
+// len + 1 bytes long. Incompressible data is stored raw.
+// Returns the compressed length, or 0 if len is too large.
+uint8_t lz_compress(uint8_t len, const uint8_t *src, uint8_t *dest);
+
+// Decompresses up to len bytes from src into dest, writing at most
+// max (up to LZ_MAX_PACKET) bytes.
+// Returns the decompressed length, or 0 if the data is malformed or truncated
+// or doesn’t fit.
+uint8_t lz_decompress(uint8_t len, const uint8_t *src, uint8_t *dest, uint8_t max);
+
+#ifndef HOST_BUILD
+// The compressed packet and the radio length byte need to fit the 64 byte fifo.
+#define LZ_MAX_TX_PAYLOAD 62
+
+// Compresses and submits len bytes (at most LZ_MAX_TX_PAYLOAD) as a variable
+// length packet, so that only the compressed size goes on air. Packets are
+// padded to radio_tx_variable_min_len() at 58 and 236kbit.
+// Returns the size sent, or 0 if len is too large.
+uint8_t lz_tx(uint8_t len, const uint8_t *data);
+
+// Receives a packet sent with lz_tx() and decompresses up to max bytes into
+// dest. Switches the receiver to variable length packets, see
+// radio_rx_variable().
+// Blocks like radio_rx(). Returns 0 if the packet is invalid.
+uint8_t lz_rx(uint8_t max, uint8_t *dest);
+#endif
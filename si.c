@@ -423,6 +423,27 @@ void radio_tx(uint8_t len, const uint8_t *data) {
   radio_gpio_rx_mode();
 }
 
+// The radio adds PKT_LEN_ADJUST to the length byte to get the number of data
+// bytes that follow it, so a positive adjust is the shortest possible packet.
+uint8_t radio_tx_variable_min_len(void) {
+  int8_t adjust = si_get_property(0x120a);
+  return adjust > 0 ? adjust : 0;
+}
+
+uint8_t radio_tx_variable(uint8_t len, const uint8_t *data) {
+  int8_t adjust = si_get_property(0x120a);
+  if (len > RADIO_MAX_VARIABLE_LEN || (int16_t) len < adjust)
+    return 0;
+  uint8_t len_byte = len - adjust;
+  si_fill_tx_fifo(1, &len_byte);
+  si_fill_tx_fifo(len, data);
+  si_tx_fifo(len + 1);
+
+  si_wait_radio_tx_done();
+  radio_gpio_rx_mode();
+  return len;
+}
+
 void si_read_rx_fifo(uint8_t len, uint8_t *dest) {
   digitalWrite(SI_CS, 0);
   spi_transfer(0x77);  // READ_RX_FIFO
@@ -432,6 +453,11 @@ void si_read_rx_fifo(uint8_t len, uint8_t *dest) {
 
 static const uint8_t request_device_state[] = {0x33};
 
+void si_set_rx_next_states(uint8_t valid, uint8_t invalid) {
+  si_rx_cmd_buf[6] = valid;
+  si_rx_cmd_buf[7] = invalid;
+}
+
 void si_start_rx(uint8_t len) {
   si_rx_cmd_buf[4] = len;
   if (len == 0) {
@@ -440,6 +466,29 @@ void si_start_rx(uint8_t len) {
   spi_select_tx(sizeof(si_rx_cmd_buf), si_rx_cmd_buf);
 }
 
+// MODEM_RSSI_CONTROL: latch RSSI at sync word detection.
+// FRR_CTL_C_MODE: expose the latched RSSI (mode 10) in fast response
+// register C.
+static const uint8_t config_rssi_latch[] = {
+  SET_PROPERTY(0x204c, 1, 0x02),
+  SET_PROPERTY(0x0202, 1, 0x0a),
+  0
+};
+
+void si_enable_rssi_latch(void) {
+  si_radio_config(config_rssi_latch);
+}
+
+uint8_t si_get_latched_rssi(void) {
+  // Fast response registers are read without waiting for CTS.
+  uint8_t rssi;
+  digitalWrite(SI_CS, 0);
+  spi_transfer(0x53);  // FRR_C_READ
+  rssi = spi_transfer(0xFF);
+  digitalWrite(SI_CS, 1);
+  return rssi;
+}
+
 uint8_t si_get_state(void) {
   uint8_t device_state;
   spi_select_tx(1, request_device_state);
@@ -459,10 +508,14 @@ void si_clear_fifo(void) {
   spi_select_tx(sizeof(cmd_clear_fifo), cmd_clear_fifo);
 }
 
+uint8_t si_poll_packet(void) {
+  // PACKET_RX or CRC_error interrupt pending
+  return si_check_interrupt(2, SI_RX_PACKET | SI_RX_CRC_ERROR, PENDING_INTERRUPTS_CLEAR);
+}
+
 uint8_t si_wait_packet(void) {
   uint8_t res;
-  while ((res = si_check_interrupt(2, 0x18, PENDING_INTERRUPTS_CLEAR)) ==
-           0) { // PACKET_RX or CRC_error interrupt pending
+  while ((res = si_poll_packet()) == 0) {
     si_wait_interrupt_state();
   }
   return res;
@@ -472,14 +525,19 @@ void si_notify_nirq(void) {
   interrupt_state = 1;
 }
 
-uint8_t radio_rx(uint8_t len, uint8_t *dest) {
+// Retrieves up to len bytes of the current packet. (Re)starts the receiver
+// for packets of rx_len bytes (0: variable length) if it isn’t receiving
+// those. A receiver started for variable length packets also serves fixed
+// length reads, not vice versa.
+static uint8_t rx_packet(uint8_t rx_len, uint8_t len, uint8_t *dest, uint8_t *status) {
+  *status = 0;
   if (si_get_state() != SI_STATE_RX ||
-      (si_rx_cmd_buf[4] != 0 && si_rx_cmd_buf[4] != len)) {
+      (si_rx_cmd_buf[4] != 0 && si_rx_cmd_buf[4] != rx_len)) {
     si_clear_fifo();
-    si_start_rx(len);
+    si_start_rx(rx_len);
   }
 
-  uint8_t int_status = si_check_interrupt(2, 0x18, PENDING_INTERRUPTS_CLEAR);
+  uint8_t int_status = si_poll_packet();
   if (!int_status) {
     // In case the RX fifo buffered a previous packet, retrieve this first.
     // This should not happen unless the function is called with only a subset
@@ -501,15 +559,16 @@ uint8_t radio_rx(uint8_t len, uint8_t *dest) {
   if (rxfifo < (int8_t) len)
     len = rxfifo;
 
-  // Check pending interrupts to confirm that data is available and valid.
-  if ((int_status & 0x8) != 0) { // CRC error
-    // Clear fifos to discard bad data.
+  *status = int_status;
+  if ((int_status & SI_RX_CRC_ERROR) != 0) {
+    // Hand out the bad data, but don’t let any remainder leak into the next
+    // packet.
+    si_read_rx_fifo(len, dest);
     si_clear_fifo();
-    si_err('C');
-    return 0;
+    return len;
   }
 
-  if ((int_status & 0x10) != 0) { // RX pending
+  if ((int_status & SI_RX_PACKET) != 0) {
     si_read_rx_fifo(len, dest);
     return len;
   }
@@ -521,6 +580,30 @@ uint8_t radio_rx(uint8_t len, uint8_t *dest) {
   return 0;
 }
 
+uint8_t radio_rx_raw(uint8_t len, uint8_t *dest, uint8_t *status) {
+  return rx_packet(len, len, dest, status);
+}
+
+uint8_t radio_rx(uint8_t len, uint8_t *dest) {
+  uint8_t status;
+  len = radio_rx_raw(len, dest, &status);
+  if ((status & SI_RX_CRC_ERROR) != 0) {
+    si_err('C');
+    return 0;
+  }
+  return len;
+}
+
+uint8_t radio_rx_variable(uint8_t size, uint8_t *dest) {
+  uint8_t status;
+  size = rx_packet(0, size, dest, &status);
+  if ((status & SI_RX_CRC_ERROR) != 0) {
+    si_err('C');
+    return 0;
+  }
+  return size;
+}
+
 void radio_halt(void) {
   // TODO: disable 32K osc
   si_change_state(SI_STATE_SLEEP);  // go to sleep
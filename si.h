@@ -14,6 +14,20 @@ uint8_t radio_init(const uint8_t *si_config_p);
 // appropriate HC12_PACKET_SIZE constant.
 void radio_tx(uint8_t len, const uint8_t *data);
 
+// The longest variable length packet: the configured maximum length of the
+// data field, which together with the length byte fills the 64 byte fifo.
+#define RADIO_MAX_VARIABLE_LEN 63
+
+// The shortest variable length packet with the current modem config, i.e. its
+// length adjust if positive: 8 bytes at 58kbit, 24 bytes at 236kbit, else 0.
+uint8_t radio_tx_variable_min_len(void);
+
+// Submits a variable length packet, prefixed by a length byte adjusted for the
+// current modem config. Receive it with radio_rx_variable().
+// Returns len, or 0 if nothing was sent because len is outside
+// radio_tx_variable_min_len() .. RADIO_MAX_VARIABLE_LEN. Pad shorter packets.
+uint8_t radio_tx_variable(uint8_t len, const uint8_t *data);
+
 // Retrieves len bytes of data from the current packet.
 // Blocks until a packet is received.
 // Starts the receiver (`radio_start_rx()`) if not yet started.
@@ -22,6 +36,17 @@ void radio_tx(uint8_t len, const uint8_t *data);
 // dest must be at least min(8, len) bytes long.
 uint8_t radio_rx(uint8_t len, uint8_t *dest);
 
+// Like radio_rx(), but also hands out packets that failed the CRC check
+// instead of discarding them, e.g. for sniffing or software error correction.
+// *status receives the packet handler flags (SI_RX_PACKET, SI_RX_CRC_ERROR)
+// or 0 if the data was already buffered and its CRC state is unknown.
+uint8_t radio_rx_raw(uint8_t len, uint8_t *dest, uint8_t *status);
+
+// Like radio_rx(), but for packets sent with radio_tx_variable(): keeps the
+// receiver in variable length mode (si_start_rx(0)) and returns the length
+// byte followed by the data. size is the size of dest, not a packet length.
+uint8_t radio_rx_variable(uint8_t size, uint8_t *dest);
+
 // Puts the radio in sleep state for low power consumption.
 void radio_halt(void);
 
@@ -37,11 +62,25 @@ void si_set_tx_power(uint8_t power);
 // configure the first byte as length.
 void si_start_rx(uint8_t len);
 
+// Sets the states the radio enters after receiving a valid packet or one
+// with a CRC error. Takes effect with the next si_start_rx().
+// The defaults are SI_STATE_RX and SI_STATE_READY, i.e. the receiver needs to
+// be restarted after a CRC error. Use SI_STATE_RX for both to keep receiving
+// continuously without software intervention.
+void si_set_rx_next_states(uint8_t valid, uint8_t invalid);
+
+// Packet handler interrupt flags as returned by si_wait_packet().
+#define SI_RX_PACKET 0x10
+#define SI_RX_CRC_ERROR 0x08
+
 // blocks in wfi() until si_notify_nirq is called and one of the
-// interrupt flags (0x10: packet received, 0x08: CRC error) is set.
+// interrupt flags (SI_RX_PACKET, SI_RX_CRC_ERROR) is set.
 // returns the interrupt status flags
 uint8_t si_wait_packet(void);
 
+// Non-blocking variant of si_wait_packet(). Returns 0 if no packet is pending.
+uint8_t si_poll_packet(void);
+
 // blocks in wfi() until si_notify_nirq is called and the
 // PACKET_SENT interrupt flag is set.
 void si_wait_radio_tx_done(void);
@@ -66,6 +105,14 @@ void si_radio_config(const uint8_t *si_config_p);
 // Returns the current device state (see SI_STATE_…).
 uint8_t si_get_state(void);
 
+// Latches the RSSI at sync word detection, so that it can be retrieved
+// for each received packet using si_get_latched_rssi().
+void si_enable_rssi_latch(void);
+
+// Returns the RSSI latched for the last packet.
+// The value is in 0.5dB steps, roughly dBm = rssi / 2 - 134.
+uint8_t si_get_latched_rssi(void);
+
 // Lower level internal APIs
 
 // clears RX & TX fifos
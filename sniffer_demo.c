@@ -0,0 +1,128 @@
+#include <stdint.h>
+
+#include "Arduino.h"
+#include "si.h"
+#include "stm8.h"
+#include "hc12.h"
+
+// Sniffer firmware: receives continuously and streams every packet (including
+// those with CRC errors) as binary records over the UART (HC12_TX pin).
+// Use `tools/sniff2pcap.py` to turn the stream into a pcap file.
+
+// The modem config to listen on.
+#define SNIFFER_CONFIG si_config_236kbit
+#define SNIFFER_CHANNEL 1
+
+// A 49 byte packet at 236kbit arrives every ~2ms and results in a ~58 byte
+// record, so the UART needs to move at least ~30kB/s.
+#define SNIFFER_BAUD 460800
+
+// Record layout (multi-byte values are little endian):
+//   0: SNIFFER_MAGIC
+//   1: flags (SNIFFER_FLAG_…)
+//   2: latched RSSI (see si_get_latched_rssi)
+//   3: number of records dropped before this one (saturating)
+//   4: timestamp in ms (uint32)
+//   8: payload length
+//   9: payload
+#define SNIFFER_MAGIC 0xa5
+#define SNIFFER_FLAG_CRC_ERROR 0x01
+#define SNIFFER_HEADER_SIZE 9
+
+// The Si4463 RX fifo is 64 bytes.
+#define SNIFFER_MAX_PAYLOAD 64
+
+// Ring buffer for the outgoing UART stream. uint8_t indices wrap by themselves.
+static uint8_t ring[256];
+static uint8_t ring_head;
+static uint8_t ring_tail;
+static uint8_t dropped;
+
+static uint8_t packet[SNIFFER_MAX_PAYLOAD];
+
+void on_portC(void) {  // IO1 / IRQ
+  if (digitalRead(SI_IRQ) == 0) {
+    si_notify_nirq();
+  }
+}
+
+static void ring_put(uint8_t c) {
+  ring[ring_head++] = c;
+}
+
+static void ring_put32(uint32_t v) {
+  ring_put(v);
+  ring_put(v >> 8);
+  ring_put(v >> 16);
+  ring_put(v >> 24);
+}
+
+// Moves as many bytes to the UART as it takes without blocking.
+static void uart_drain(void) {
+  while (ring_tail != ring_head && (UART1_SR & 0x80)) {  // TXE
+    UART1_DR = ring[ring_tail++];
+  }
+}
+
+// Queues a record, or counts it as dropped if the ring is too full.
+// Never blocks, so that the radio is serviced in time.
+static void emit_record(uint8_t flags, uint8_t rssi, uint8_t len) {
+  uint8_t used = ring_head - ring_tail;
+  if ((uint16_t) used + SNIFFER_HEADER_SIZE + len >= sizeof(ring)) {
+    if (dropped != 0xff)
+      dropped++;
+    return;
+  }
+  ring_put(SNIFFER_MAGIC);
+  ring_put(flags);
+  ring_put(rssi);
+  ring_put(dropped);
+  ring_put32(millis());
+  ring_put(len);
+  for (uint8_t i = 0; i < len; i++)
+    ring_put(packet[i]);
+  dropped = 0;
+}
+
+void setup(void) {
+  SERIAL_INIT(SNIFFER_BAUD);
+
+  // C4 (IRQ): Low while a radio interrupt is pending.
+  attachInterrupt(SI_IRQ, &on_portC, FALLING); // C4
+
+  if (!radio_init(SNIFFER_CONFIG))
+    return;
+  si_set_channel(SNIFFER_CHANNEL);
+  si_enable_rssi_latch();
+
+  // Stay in RX after both valid and invalid packets, so that no software
+  // re-arming is needed between packets.
+  si_set_rx_next_states(SI_STATE_RX, SI_STATE_RX);
+  si_clear_fifo();
+  si_start_rx(0);
+}
+
+void loop(void) {
+  uart_drain();
+
+  // NIRQ stays low while an interrupt is pending, polling the pin avoids
+  // SPI traffic while idle.
+  if (digitalRead(SI_IRQ))
+    return;
+
+  uint8_t status = si_poll_packet();
+  if (!status)
+    return;  // e.g. sync word detection
+
+  // Read the latched RSSI and the fifo right away: the receiver is already
+  // armed for the next packet.
+  uint8_t rssi = si_get_latched_rssi();
+  int8_t len = si_get_rx_fifo_size();
+  if (len <= 0)
+    return;
+  if (len > SNIFFER_MAX_PAYLOAD)
+    len = SNIFFER_MAX_PAYLOAD;
+  si_read_rx_fifo(len, packet);
+
+  emit_record((status & SI_RX_CRC_ERROR) ? SNIFFER_FLAG_CRC_ERROR : 0, rssi, len);
+}
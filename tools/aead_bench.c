@@ -0,0 +1,186 @@
+// Host test vectors and benchmark for aead.c.
+//
+// The vectors are generated by tools/aead_vectors.py, an independent Python
+// implementation checked against the Speck64/128 paper vector.
+// Besides host timings, the benchmark lists the number of block cipher calls
+// on the critical path of each packet; codec_bench.c measures the STM8 cost.
+//
+// Usage: tools/aead_bench
+
+#include <stdio.h>
+#include <string.h>
+
+#include "aead.h"
+#include "bench.h"
+
+static const uint8_t key[AEAD_KEY_SIZE] = {
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+  0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+};
+
+// Id used for the receiving side, differs from all senders.
+#define RX_ID 0x00
+
+struct vector {
+  uint8_t id;
+  uint32_t counter;
+  uint8_t len;
+  uint8_t payload[AEAD_MAX_PAYLOAD];
+  uint8_t packet[AEAD_MAX_PAYLOAD + AEAD_OVERHEAD];
+};
+
+static const struct vector vectors[] = {
+  {0x1, 0x0, 1, {0x41},
+   {0x01, 0x00, 0x00, 0x00, 0x00, 0x5a, 0xd5, 0x96, 0x3e, 0xd8}},
+  {0x1, 0x1, 10, {0x4f, 0x70, 0x65, 0x6e, 0x48, 0x43, 0x31, 0x32, 0x0d, 0x0a},
+   {0x01, 0x01, 0x00, 0x00, 0x00, 0xbc, 0x6e, 0xb0, 0x10, 0x99, 0x57, 0xdc, 0x60, 0x33, 0xe9, 0x51, 0x02, 0x30, 0x4b}},
+  {0x2, 0x12345678, 40, {0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27},
+   {0x02, 0x78, 0x56, 0x34, 0x12, 0x5c, 0x29, 0xed, 0x90, 0xc4, 0x65, 0xbf, 0xd7, 0xb1, 0x73, 0xa8, 0xd8, 0xa3, 0xd9, 0x18, 0xe4, 0x42, 0xf5, 0x51, 0x20, 0xae, 0xd1, 0x3a, 0x8f, 0xb5, 0xdf, 0x75, 0xb1, 0x5c, 0xf8, 0x59, 0xec, 0xcb, 0xcd, 0xf2, 0xf9, 0xc5, 0x3d, 0x35, 0x1e, 0xdf, 0xc1, 0x52, 0x75}},
+  {0xfe, 0xfffffffe, 16, {0x73, 0x69, 0x78, 0x74, 0x65, 0x65, 0x6e, 0x20, 0x62, 0x79, 0x74, 0x65, 0x20, 0x6d, 0x73, 0x67},
+   {0xfe, 0xfe, 0xff, 0xff, 0xff, 0xd9, 0x0d, 0x49, 0xe9, 0xac, 0x4f, 0x70, 0x65, 0x88, 0xda, 0xd6, 0x21, 0xc9, 0x6f, 0xc0, 0x83, 0x77, 0xe5, 0x70, 0x26}},
+};
+
+static int check_vectors(void) {
+  uint8_t packet[AEAD_MAX_PAYLOAD + AEAD_OVERHEAD];
+  uint8_t plain[AEAD_MAX_PAYLOAD];
+  int err = 0;
+
+  for (unsigned v = 0; v < sizeof(vectors) / sizeof(*vectors); v++) {
+    const struct vector *t = &vectors[v];
+    uint8_t n = t->len + AEAD_OVERHEAD;
+
+    aead_init(key, t->id, t->counter, 0);
+    if (aead_seal(t->len, t->payload, packet) != n || memcmp(packet, t->packet, n)) {
+      printf("vector %u: seal mismatch\n", v);
+      err = 1;
+      continue;
+    }
+    // The own packets are rejected.
+    if (aead_open(n, packet, plain)) {
+      printf("vector %u: accepted own packet\n", v);
+      err = 1;
+    }
+
+    aead_init(key, RX_ID, 0, 0);
+    if (aead_open(n, t->packet, plain) != t->len || memcmp(plain, t->payload, t->len)) {
+      printf("vector %u: open failed\n", v);
+      err = 1;
+    }
+    if (aead_open(n, t->packet, plain)) {
+      printf("vector %u: accepted replay\n", v);
+      err = 1;
+    }
+
+    // Any modification is detected.
+    for (unsigned bit = 0; bit < n * 8u; bit++) {
+      memcpy(packet, t->packet, n);
+      packet[bit / 8] ^= 1 << (bit % 8);
+      aead_init(key, RX_ID, 0, 0);
+      if (aead_open(n, packet, plain)) {
+        printf("vector %u: accepted packet with bit %u flipped\n", v, bit);
+        err = 1;
+        break;
+      }
+    }
+  }
+
+  // A receiver restarted with its persisted counter rejects old packets,
+  // also with precomputed keystreams.
+  {
+    const struct vector *t = &vectors[1];
+    uint8_t n = t->len + AEAD_OVERHEAD;
+    aead_init(key, RX_ID, 0, 0);
+    aead_open(vectors[0].len + AEAD_OVERHEAD, vectors[0].packet, plain);
+    aead_precompute();
+    if (aead_open(n, t->packet, plain) != t->len || memcmp(plain, t->payload, t->len)) {
+      printf("open with precomputed keystream failed\n");
+      err = 1;
+    }
+    uint32_t persisted = aead_get_rx_counter();
+    aead_init(key, RX_ID, 0, persisted);
+    if (aead_open(n, t->packet, plain) || aead_open(vectors[0].len + AEAD_OVERHEAD, vectors[0].packet, plain)) {
+      printf("accepted replay after restart\n");
+      err = 1;
+    }
+    aead_precompute();
+    if (aead_open(n, t->packet, plain)) {
+      printf("accepted replay after restart (precomputed)\n");
+      err = 1;
+    }
+  }
+
+  // The last counter value is reserved.
+  aead_init(key, 1, 0xffffffff, 0);
+  if (aead_seal(1, (const uint8_t *) "x", packet)) {
+    printf("sealed with exhausted counter\n");
+    err = 1;
+  }
+  printf("test vectors: %s\n\n", err ? "FAILED" : "ok");
+  return err;
+}
+
+enum { SEAL, SEAL_PRECOMPUTED, OPEN, OPEN_PRECOMPUTED };
+
+static void bench(uint8_t len, int mode) {
+  static const char *const names[] = {"seal", "seal (precomputed)", "open", "open (precomputed)"};
+  const unsigned rounds = 100000;
+  uint8_t payload[AEAD_MAX_PAYLOAD] = {0};
+  uint8_t packets[2][AEAD_MAX_PAYLOAD + AEAD_OVERHEAD];
+  uint8_t packet[AEAD_MAX_PAYLOAD + AEAD_OVERHEAD];
+  uint8_t plain[AEAD_MAX_PAYLOAD];
+  uint8_t n = len + AEAD_OVERHEAD;
+  unsigned blocks = (len + 7) / 8;
+
+  // Two consecutive packets from the peer: the first one teaches the receiver
+  // the peer id, the second one is timed.
+  aead_init(key, 1, 0, 0);
+  aead_seal(len, payload, packets[0]);
+  aead_seal(len, payload, packets[1]);
+  aead_init(key, RX_ID, 0, 0);
+
+  double ns = 0;
+  uint64_t cycles = 0;
+  for (unsigned r = 0; r < rounds; r++) {
+    if (mode == OPEN || mode == OPEN_PRECOMPUTED) {
+      aead_init(key, RX_ID, 0, 0);  // reset the replay counter
+      aead_open(n, packets[0], plain);
+    }
+    if (mode == SEAL_PRECOMPUTED || mode == OPEN_PRECOMPUTED)
+      aead_precompute();
+    double start = now_ns();
+    uint64_t start_cycles = host_cycles();
+    if (mode == OPEN || mode == OPEN_PRECOMPUTED)
+      aead_open(n, packets[1], plain);
+    else
+      aead_seal(len, payload, packet);
+    cycles += host_cycles() - start_cycles;
+    ns += now_ns() - start;
+  }
+
+  // keystream (payload + tag mask) and CBC-MAC (B_0 + payload)
+  unsigned calls = mode == SEAL_PRECOMPUTED || mode == OPEN_PRECOMPUTED ? blocks + 1 : 2 * blocks + 2;
+  printf("%-20s %4u %8u %10.0f", names[mode], len, calls, ns / rounds);
+#ifdef HAVE_HOST_CYCLES
+  printf(" %12.0f", (double) cycles / rounds);
+#endif
+  printf("\n");
+}
+
+int main(void) {
+  if (check_vectors())
+    return 1;
+
+  // Payload sizes filling the HC12 packet sizes, and the maximum.
+  static const uint8_t sizes[] = {12 - AEAD_OVERHEAD, 20 - AEAD_OVERHEAD, 33 - AEAD_OVERHEAD,
+                                  49 - AEAD_OVERHEAD, AEAD_MAX_PAYLOAD};
+  printf("host timings only (x86 TSC cycles), see codec_bench.c for the STM8\n\n");
+  printf("%-20s %4s %8s %10s", "operation", "len", "blocks", "ns/packet");
+#ifdef HAVE_HOST_CYCLES
+  printf(" %12s", "cycles/packet");
+#endif
+  printf("\n");
+  for (int mode = SEAL; mode <= OPEN_PRECOMPUTED; mode++)
+    for (unsigned i = 0; i < sizeof(sizes); i++)
+      bench(sizes[i], mode);
+  return 0;
+}
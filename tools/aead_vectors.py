@@ -0,0 +1,82 @@
+#!/usr/bin/env python3
+"""
+Reference implementation of the aead.c packet format, used to generate the
+test vectors in tools/aead_bench.c independently of the C code.
+
+Usage: tools/aead_vectors.py
+
+Cipher: Speck64/128 (checked against the vector from the Speck paper).
+Packet: sender id (1), counter (4, LE), ciphertext, tag (4)
+  A_i = counter | id | 0 | i | 0x01     CTR blocks, A_0 masks the tag
+  B_0 = counter | id | len | 0 | 0x02   CBC-MAC IV block
+  tag = first 4 bytes of CBC-MAC(B_0, zero padded ciphertext) ^ E(A_0)
+"""
+M = 0xffffffff
+
+
+def ror(x, r):
+  return ((x >> r) | (x << (32 - r))) & M
+
+
+def rol(x, r):
+  return ((x << r) | (x >> (32 - r))) & M
+
+
+def speck_schedule(key):
+  w = [int.from_bytes(key[i:i + 4], 'little') for i in range(0, 16, 4)]
+  k, l = [w[0]], w[1:]
+  for i in range(26):
+    l.append(((k[i] + ror(l[i], 8)) & M) ^ i)
+    k.append(rol(k[i], 3) ^ l[i + 3])
+  return k
+
+
+def speck_encrypt(rk, block):
+  y = int.from_bytes(block[0:4], 'little')
+  x = int.from_bytes(block[4:8], 'little')
+  for k in rk:
+    x = ((ror(x, 8) + y) & M) ^ k
+    y = rol(y, 3) ^ x
+  return y.to_bytes(4, 'little') + x.to_bytes(4, 'little')
+
+
+def xor(a, b):
+  return bytes(i ^ j for i, j in zip(a, b))
+
+
+def seal(key, node_id, counter, payload):
+  rk = speck_schedule(key)
+  ctr = counter.to_bytes(4, 'little')
+  ct = b''
+  for i in range(0, len(payload), 8):
+    ks = speck_encrypt(rk, ctr + bytes([node_id, 0, i // 8 + 1, 1]))
+    ct += xor(payload[i:i + 8], ks)
+  mac = speck_encrypt(rk, ctr + bytes([node_id, len(payload), 0, 2]))
+  for i in range(0, len(ct), 8):
+    mac = speck_encrypt(rk, xor(mac, ct[i:i + 8].ljust(8, b'\0')))
+  tag = xor(mac, speck_encrypt(rk, ctr + bytes([node_id, 0, 0, 1])))[:4]
+  return bytes([node_id]) + ctr + ct + tag
+
+
+def c_array(data):
+  return '{' + ', '.join(f'0x{b:02x}' for b in data) + '}'
+
+
+def main():
+  rk = speck_schedule(bytes([0, 1, 2, 3, 8, 9, 10, 11, 16, 17, 18, 19, 24, 25, 26, 27]))
+  assert speck_encrypt(rk, bytes.fromhex('2d4375747465723b')) == bytes.fromhex('8b024e4548a56f8c')
+
+  key = bytes(range(16))
+  cases = [
+    (1, 0, b'A'),
+    (1, 1, b'OpenHC12\r\n'),
+    (2, 0x12345678, bytes(range(40))),
+    (0xfe, 0xfffffffe, b'sixteen byte msg'),
+  ]
+  for node_id, counter, payload in cases:
+    print(f'  {{{node_id:#x}, {counter:#x}, {len(payload)}, {c_array(payload)},')
+    print(f'   {c_array(seal(key, node_id, counter, payload))}}},')
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,39 @@
+// Shared helpers for the host benchmarks in tools/.
+//
+// Build & run: make tools/<name> && tools/<name> [args]
+//
+// All timings taken here are for the host CPU and only useful for comparing
+// variants. For STM8 numbers, see codec_bench.c.
+
+#include <stdint.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_HOST_CYCLES 1
+#endif
+
+static uint32_t rng_state = 0x12345678;
+
+// xorshift32, deterministic so that runs are comparable.
+static inline uint32_t rng(void) {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static inline double now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// Host CPU timestamp counter (x86 TSC), 0 where not available.
+static inline uint64_t host_cycles(void) {
+#ifdef HAVE_HOST_CYCLES
+  return __rdtsc();
+#else
+  return 0;
+#endif
+}
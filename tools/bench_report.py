@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""
+Turns the `B,…` result lines logged by `link_bench.c` into tables.
+
+Usage:
+  swimcat/swimcat.py --continue | tee bench.log
+  tools/bench_report.py bench.log [--json]
+
+Result line format: B,<test>,<kbit>,<power>,<packet_len>,<sent>,<received>,<ms>
+  ping: <ms> is the summed round trip time of all received packets
+  tput: <ms> is the time the initiator took to send all packets
+Repeated runs are accumulated.
+
+Codec timings logged by `codec_bench.c` are reported as well:
+  C,<op>,<payload_len>,<packet_len>,<iterations>,<cycles>
+"""
+import argparse
+import collections
+import json
+import sys
+
+
+# Preamble (6), sync word (2) and radio CRC (1), see config_common in si.c.
+AIR_OVERHEAD = 9
+
+
+def parse(lines):
+  results = collections.defaultdict(lambda: [0, 0, 0])
+  packet_len = {}
+  codecs = collections.defaultdict(lambda: [0, 0])
+  for line in lines:
+    fields = line.strip().split(',')
+    if len(fields) == 6 and fields[0] == 'C':
+      try:
+        length, plen, iterations, cycles = map(int, fields[2:])
+      except ValueError:
+        continue
+      acc = codecs[fields[1], length, plen]
+      acc[0] += iterations
+      acc[1] += cycles
+      continue
+    if len(fields) != 8 or fields[0] != 'B':
+      continue
+    try:
+      kbit, power, length, sent, received, ms = map(int, fields[2:])
+    except ValueError:
+      continue
+    acc = results[fields[1], kbit, power]
+    acc[0] += sent
+    acc[1] += received
+    acc[2] += ms
+    packet_len[kbit] = length
+  return results, packet_len, codecs
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+  parser.add_argument('log', nargs='?', type=argparse.FileType('r'), default=sys.stdin)
+  parser.add_argument('--json', action='store_true', help='print the aggregated results as JSON')
+  parser.add_argument('--f-cpu', type=float, default=16e6, help='STM8 clock to convert cycles to us')
+  args = parser.parse_args()
+
+  results, packet_len, codecs = parse(args.log)
+  rates = sorted({kbit for _, kbit, _ in results})
+  powers = sorted({power for test, _, power in results if test == 'tput'})
+
+  if args.json:
+    json.dump([{'test': t, 'kbit': k, 'power': p, 'packet_len': packet_len[k],
+                'sent': s, 'received': r, 'ms': ms}
+               for (t, k, p), (s, r, ms) in sorted(results.items())] +
+              [{'test': op, 'payload_len': length, 'packet_len': plen,
+                'iterations': n, 'cycles': cycles / n, 'us': cycles / n * 1e6 / args.f_cpu}
+               for (op, length, plen), (n, cycles) in sorted(codecs.items())], sys.stdout, indent=1)
+    print()
+    return
+
+  if codecs:
+    print('Codec cost on the STM8 (vs. packet airtime at 236kbit)\n')
+    print('| op | payload | packet | us/packet | cycles/packet | airtime us |')
+    print('|----|--------:|-------:|----------:|--------------:|-----------:|')
+    for (op, length, plen), (n, cycles) in sorted(codecs.items()):
+      airtime = (AIR_OVERHEAD + plen) * 8000 / 236
+      print(f'| {op} | {length} | {plen} | {cycles / n * 1e6 / args.f_cpu:.0f} | '
+            f'{cycles / n:.0f} | {airtime:.0f} |')
+    print()
+  if not results:
+    return
+
+  print('Latency (ping-pong)\n')
+  print('| kbit | len | power | lost | avg RTT ms |')
+  print('|-----:|----:|------:|-----:|-----------:|')
+  for (test, kbit, power), (sent, received, ms) in sorted(results.items()):
+    if test == 'ping':
+      rtt = f'{ms / received:.1f}' if received else '-'
+      print(f'| {kbit} | {packet_len[kbit]} | {power} | {sent - received}/{sent} | {rtt} |')
+
+  print('\nThroughput (payload bits received / send duration, best power)\n')
+  print('| kbit | len | sent pkt/s | goodput kbit/s |')
+  print('|-----:|----:|-----------:|---------------:|')
+  for kbit in rates:
+    best = None
+    for power in powers:
+      sent, received, ms = results.get(('tput', kbit, power), (0, 0, 0))
+      if ms and (best is None or received > best[1]):
+        best = (sent, received, ms)
+    if best:
+      sent, received, ms = best
+      print(f'| {kbit} | {packet_len[kbit]} | {sent * 1000 / ms:.1f} | '
+            f'{received * packet_len[kbit] * 8 / ms:.2f} |')
+
+  print('\nPacket error rate vs TX power\n')
+  print('| kbit | ' + ' | '.join(f'P={p}' for p in powers) + ' |')
+  print('|-----:|' + '------:|' * len(powers))
+  for kbit in rates:
+    cells = []
+    for power in powers:
+      sent, received, _ = results.get(('tput', kbit, power), (0, 0, 0))
+      cells.append(f'{1 - received / sent:.3f}' if sent else '-')
+    print(f'| {kbit} | ' + ' | '.join(cells) + ' |')
+
+
+if __name__ == '__main__':
+  main()
@@ -0,0 +1,163 @@
+// Host benchmark for fec.c: decode speed and goodput vs bit errors.
+//
+// Goodput is the fraction of the modem rate that ends up as intact payload,
+// counting preamble, sync word and radio CRC as overhead. Without FEC any bit
+// error drops the packet.
+//
+// Two channel models are simulated: independent bit errors (BER) and a single
+// burst per packet, in which each bit is flipped with 50% probability.
+//
+// Usage: tools/fec_bench [payload_len]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "fec.h"
+
+// Preamble (6), sync word (2) and radio CRC (1), see config_common in si.c.
+#define AIR_OVERHEAD 9
+#define TRIALS 20000
+
+// Flips each bit with probability ber, returns the number of flipped bits.
+static unsigned add_noise(uint8_t len, uint8_t *data, double ber) {
+  uint32_t threshold = (uint32_t) (ber * 4294967295.0);
+  unsigned flips = 0;
+  for (unsigned i = 0; i < len * 8u; i++) {
+    if (rng() < threshold) {
+      data[i / 8] ^= 1 << (i % 8);
+      flips++;
+    }
+  }
+  return flips;
+}
+
+// Flips each bit of a burst_len bits long burst at a random position with
+// 50% probability, returns the number of flipped bits.
+static unsigned add_burst(uint8_t len, uint8_t *data, unsigned burst_len) {
+  unsigned bits = len * 8u;
+  if (burst_len > bits)
+    burst_len = bits;
+  unsigned start = rng() % (bits - burst_len + 1);
+  unsigned flips = 0;
+  for (unsigned i = start; i < start + burst_len; i++) {
+    if (rng() & 1) {
+      data[i / 8] ^= 1 << (i % 8);
+      flips++;
+    }
+  }
+  return flips;
+}
+
+static void bench_decode(uint8_t len) {
+  uint8_t payload[FEC_MAX_PAYLOAD], coded[FEC_ENCODED_SIZE(FEC_MAX_PAYLOAD)];
+  uint8_t decoded[FEC_MAX_PAYLOAD + 1];
+  const unsigned rounds = 200000;
+  volatile uint8_t sink = 0;
+
+  for (uint8_t i = 0; i < len; i++)
+    payload[i] = rng();
+  uint8_t coded_len = fec_encode(len, payload, coded);
+
+  double start = now_ns();
+  uint64_t cycles = host_cycles();
+  for (unsigned r = 0; r < rounds; r++)
+    sink += fec_decode(coded_len, coded, decoded);
+  cycles = host_cycles() - cycles;
+  double ns = now_ns() - start;
+  (void) sink;
+
+  double bytes = (double) rounds * len;
+  printf("decode (host only): %.2f ns/byte", ns / bytes);
+#ifdef HAVE_HOST_CYCLES
+  printf(", %.1f x86 TSC cycles/byte", cycles / bytes);
+#endif
+  printf(" (%u byte payload)\n\n", len);
+}
+
+// Runs TRIALS packets through the channel model, noise(len, data, param).
+static void simulate(uint8_t len, unsigned (*noise)(uint8_t, uint8_t *, double),
+                     double param, const char *fmt) {
+  uint8_t payload[FEC_MAX_PAYLOAD], coded[FEC_ENCODED_SIZE(FEC_MAX_PAYLOAD)];
+  uint8_t decoded[FEC_MAX_PAYLOAD + 1], plain[FEC_MAX_PAYLOAD + 1];
+  uint8_t coded_len = FEC_ENCODED_SIZE(len);
+  unsigned plain_ok = 0, fec_ok = 0, undetected = 0;
+
+  for (unsigned t = 0; t < TRIALS; t++) {
+    for (uint8_t i = 0; i < len; i++)
+      payload[i] = rng();
+
+    // Payload plus radio CRC byte.
+    memcpy(plain, payload, len);
+    plain_ok += noise(len + 1, plain, param) == 0;
+
+    fec_encode(len, payload, coded);
+    noise(coded_len, coded, param);
+    if (fec_decode(coded_len, coded, decoded) == len) {
+      if (memcmp(payload, decoded, len) == 0)
+        fec_ok++;
+      else
+        undetected++;
+    }
+  }
+  printf(fmt, param);
+  printf(" %10.4f %10.4f %10.3f %10.3f %10u\n",
+         1 - (double) plain_ok / TRIALS, 1 - (double) fec_ok / TRIALS,
+         len * (double) plain_ok / TRIALS / (AIR_OVERHEAD + len),
+         len * (double) fec_ok / TRIALS / (AIR_OVERHEAD + coded_len), undetected);
+}
+
+static unsigned ber_noise(uint8_t len, uint8_t *data, double ber) {
+  return add_noise(len, data, ber);
+}
+
+static unsigned burst_noise(uint8_t len, uint8_t *data, double burst_len) {
+  return add_burst(len, data, (unsigned) burst_len);
+}
+
+int main(int argc, char **argv) {
+  uint8_t len = argc > 1 ? atoi(argv[1]) : 19;
+  if (len == 0 || len > FEC_MAX_PAYLOAD) {
+    fprintf(stderr, "payload length must be 1..%d\n", FEC_MAX_PAYLOAD);
+    return 1;
+  }
+
+  // Sanity checks: round trip, single bit correction in every position and
+  // correction of every burst as long as the number of codewords.
+  uint8_t payload[FEC_MAX_PAYLOAD], coded[FEC_ENCODED_SIZE(FEC_MAX_PAYLOAD)];
+  uint8_t decoded[FEC_MAX_PAYLOAD + 1];
+  for (uint8_t i = 0; i < len; i++)
+    payload[i] = rng();
+  uint8_t coded_len = fec_encode(len, payload, coded);
+  for (unsigned bit = 0; bit < coded_len * 8u; bit++) {
+    coded[bit / 8] ^= 1 << (bit % 8);
+    if (fec_decode(coded_len, coded, decoded) != len || memcmp(payload, decoded, len)) {
+      fprintf(stderr, "failed to correct bit %u\n", bit);
+      return 1;
+    }
+    coded[bit / 8] ^= 1 << (bit % 8);
+  }
+  for (unsigned start = 0; start + coded_len <= coded_len * 8u; start++) {
+    fec_encode(len, payload, coded);
+    for (unsigned bit = start; bit < start + coded_len; bit++)
+      coded[bit / 8] ^= 1 << (bit % 8);
+    if (fec_decode(coded_len, coded, decoded) != len || memcmp(payload, decoded, len)) {
+      fprintf(stderr, "failed to correct %u bit burst at bit %u\n", coded_len, start);
+      return 1;
+    }
+  }
+
+  bench_decode(len);
+
+  static const double bers[] = {1e-4, 3e-4, 1e-3, 3e-3, 1e-2, 3e-2};
+  printf("%8s %10s %10s %10s %10s %10s\n", "BER", "plain PER", "FEC PER", "plain gp", "FEC gp", "undetected");
+  for (unsigned b = 0; b < sizeof(bers) / sizeof(*bers); b++)
+    simulate(len, ber_noise, bers[b], "%8.0e");
+
+  printf("\n%8s %10s %10s %10s %10s %10s\n", "burst", "plain PER", "FEC PER", "plain gp", "FEC gp", "undetected");
+  static const unsigned bursts[] = {2, 4, 8, 16, 32, 64, 128};
+  for (unsigned b = 0; b < sizeof(bursts) / sizeof(*bursts); b++)
+    simulate(len, burst_noise, bursts[b], "%8.0f");
+  return 0;
+}
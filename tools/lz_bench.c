@@ -0,0 +1,156 @@
+// Host benchmark for lz.c: compression ratio and speed on telemetry-like data.
+//
+// Each sample is compressed as individual packets of the given size, like it
+// would be sent over the radio. The ratio counts the header byte.
+//
+// Usage: tools/lz_bench [packet_len]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "lz.h"
+
+#define SAMPLE_SIZE 8192
+
+// Example dictionary for the log sample, in practice this is application
+// specific and shared by both ends.
+static const char log_dict[] =
+    " sensor read timeout\r\nWARN node=3 seq= retry\r\n tx done\r\n"
+    "INFO node=3 seq=1 temp=21.5 hum=40 ok\r\n";
+
+// ASCII log lines with varying values.
+static size_t gen_log(uint8_t *buf) {
+  static const char *const msgs[] = {"ok", "sensor read timeout", "retry", "tx done"};
+  size_t n = 0;
+  int temp = 215, hum = 40;
+  for (unsigned seq = 0; n < SAMPLE_SIZE - 128; seq++) {
+    temp += (int) (rng() % 5) - 2;
+    hum += (int) (rng() % 3) - 1;
+    n += sprintf((char *) buf + n, "%s node=3 seq=%u temp=%d.%d hum=%d %s\r\n",
+                 rng() % 8 ? "INFO" : "WARN", seq, temp / 10, temp % 10, hum,
+                 msgs[rng() % 4]);
+  }
+  return n;
+}
+
+// Fixed 16 byte binary sensor records: id, seq, slowly changing readings.
+static size_t gen_records(uint8_t *buf) {
+  size_t n = 0;
+  uint16_t temp = 2150, hum = 400, batt = 3300;
+  for (uint16_t seq = 0; n + 16 <= SAMPLE_SIZE; seq++) {
+    temp += rng() % 5 - 2;
+    hum += rng() % 3 - 1;
+    batt -= (rng() % 16) == 0;
+    uint8_t rec[16] = {0x42, 0x03, seq, seq >> 8, temp, temp >> 8, hum, hum >> 8,
+                       batt, batt >> 8, 0, 0, 0, 0, 0, 0};
+    memcpy(buf + n, rec, 16);
+    n += 16;
+  }
+  return n;
+}
+
+static size_t gen_random(uint8_t *buf) {
+  for (size_t i = 0; i < SAMPLE_SIZE; i++)
+    buf[i] = rng();
+  return SAMPLE_SIZE;
+}
+
+// Compressed length of each packet, for SAMPLE_SIZE / packet_len + 1 packets.
+static uint8_t *comp_lens;
+
+static int run(const char *name, const uint8_t *data, size_t size, uint8_t packet_len) {
+  static uint8_t compressed[SAMPLE_SIZE * 2];
+  uint8_t plain[LZ_MAX_PACKET];
+  const unsigned rounds = 50;
+  size_t in_total = 0, out_total = 0;
+  size_t packets = 0;
+
+  // Compress (and time it).
+  double start = now_ns();
+  uint64_t cycles = host_cycles();
+  for (unsigned r = 0; r < rounds; r++) {
+    size_t out = 0;
+    packets = 0;
+    for (size_t off = 0; off < size; off += packet_len) {
+      uint8_t len = size - off < packet_len ? size - off : packet_len;
+      uint8_t c = lz_compress(len, data + off, compressed + out);
+      comp_lens[packets++] = c;
+      out += c;
+    }
+    out_total = out;
+  }
+  uint64_t comp_cycles = host_cycles() - cycles;
+  double comp_ns = now_ns() - start;
+  in_total = size;
+
+  // Decompress, verify and time it.
+  start = now_ns();
+  cycles = host_cycles();
+  for (unsigned r = 0; r < rounds; r++) {
+    size_t in = 0, off = 0;
+    for (size_t p = 0; p < packets; p++) {
+      uint8_t len = lz_decompress(comp_lens[p], compressed + in, plain, sizeof(plain));
+      if (r == 0 && (off + len > size || memcmp(plain, data + off, len) != 0 ||
+                     len != (size - off < packet_len ? size - off : packet_len))) {
+        fprintf(stderr, "%s: round trip failed in packet %zu\n", name, p);
+        return 1;
+      }
+      in += comp_lens[p];
+      off += len;
+    }
+  }
+  uint64_t decomp_cycles = host_cycles() - cycles;
+  double decomp_ns = now_ns() - start;
+
+  double bytes = (double) in_total * rounds;
+  printf("%-16s %6.3f %10.1f %12.1f", name, (double) out_total / in_total,
+         comp_ns / bytes, decomp_ns / bytes);
+#ifdef HAVE_HOST_CYCLES
+  printf(" %10.1f %12.1f", comp_cycles / bytes, decomp_cycles / bytes);
+#endif
+  printf("\n");
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  uint8_t packet_len = argc > 1 ? atoi(argv[1]) : 19;
+  if (packet_len == 0 || packet_len > LZ_MAX_PACKET) {
+    fprintf(stderr, "packet length must be 1..%d\n", LZ_MAX_PACKET);
+    return 1;
+  }
+  static uint8_t log[SAMPLE_SIZE], records[SAMPLE_SIZE], random[SAMPLE_SIZE];
+  size_t log_size = gen_log(log);
+  size_t records_size = gen_records(records);
+  size_t random_size = gen_random(random);
+
+  comp_lens = malloc(SAMPLE_SIZE / packet_len + 1);
+
+  printf("%u byte packets, host timings only (x86 TSC cycles), see codec_bench.c for the STM8\n\n",
+         packet_len);
+  printf("%-16s %6s %10s %12s", "data", "ratio", "comp ns/B", "decomp ns/B");
+#ifdef HAVE_HOST_CYCLES
+  printf(" %10s %12s", "comp cyc/B", "decomp cyc/B");
+#endif
+  printf("\n");
+
+  // Padding after the compressed data is ignored, truncation is detected.
+  uint8_t packet[LZ_MAX_PACKET + 8] = {0};
+  uint8_t plain[LZ_MAX_PACKET];
+  lz_init(NULL, 0);
+  uint8_t n = lz_compress(packet_len, log, packet);
+  if (lz_decompress(sizeof(packet), packet, plain, sizeof(plain)) != packet_len ||
+      memcmp(plain, log, packet_len) || lz_decompress(n - 1, packet, plain, sizeof(plain))) {
+    fprintf(stderr, "padded or truncated packet not handled\n");
+    return 1;
+  }
+
+  int err = 0;
+  err |= run("log", log, log_size, packet_len);
+  err |= run("records", records, records_size, packet_len);
+  err |= run("random", random, random_size, packet_len);
+  lz_init((const uint8_t *) log_dict, sizeof(log_dict) - 1);
+  err |= run("log+dict", log, log_size, packet_len);
+  return err;
+}
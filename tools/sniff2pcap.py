@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""
+Converts the binary record stream of `sniffer_demo.c` into a pcap file.
+
+Usage:
+  tools/sniff2pcap.py /dev/ttyUSB0 capture.pcap [--baud 460800]
+  tools/sniff2pcap.py recorded.bin capture.pcap
+
+Serial ports are opened with pyserial if available. Otherwise the input is
+read as a plain file (configure a tty with e.g. `stty -F /dev/ttyUSB0 460800 raw`).
+
+Packets are written with the LINKTYPE_USER0 (147) link type. Each packet's
+data starts with the sniffer flags byte (0x01: CRC error) and the latched RSSI
+byte, followed by the raw radio payload.
+"""
+import argparse
+import struct
+import sys
+import time
+
+MAGIC = 0xa5
+HEADER = struct.Struct('<BBBBIB')
+MAX_PAYLOAD = 64
+LINKTYPE_USER0 = 147
+
+
+def open_input(path, baud):
+  if baud:
+    try:
+      import serial
+      return serial.Serial(path, baud)
+    except ImportError:
+      print('pyserial not available, reading as file', file=sys.stderr)
+  return open(path, 'rb', buffering=0)
+
+
+def records(stream):
+  """Yields (flags, rssi, dropped, timestamp_ms, payload) tuples."""
+  buf = b''
+  while True:
+    # Only ask for what is available, so that complete records are written
+    # right away instead of waiting for later traffic. Unbuffered files and
+    # raw ttys return early from a plain read.
+    if hasattr(stream, 'in_waiting'):
+      data = stream.read(max(1, stream.in_waiting))
+    else:
+      data = stream.read(4096)
+    if not data:
+      return
+    buf += data
+    while len(buf) >= HEADER.size:
+      if buf[0] != MAGIC:
+        # Resynchronize on the next magic byte.
+        idx = buf.find(bytes([MAGIC]), 1)
+        buf = buf[idx:] if idx >= 0 else b''
+        continue
+      magic, flags, rssi, dropped, ts, length = HEADER.unpack_from(buf)
+      if length > MAX_PAYLOAD:
+        buf = buf[1:]
+        continue
+      if len(buf) < HEADER.size + length:
+        break
+      yield flags, rssi, dropped, ts, buf[HEADER.size:HEADER.size + length]
+      buf = buf[HEADER.size + length:]
+
+
+def main():
+  parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+  parser.add_argument('input', help='serial port or recorded stream')
+  parser.add_argument('output', help='pcap file to write')
+  parser.add_argument('--baud', type=int, help='open the input as serial port at this rate')
+  args = parser.parse_args()
+
+  out = open(args.output, 'wb')
+  out.write(struct.pack('<IHHiIII', 0xa1b2c3d4, 2, 4, 0, 0, 256, LINKTYPE_USER0))
+
+  # Device timestamps are relative to boot, anchor them at the first record.
+  base = None
+  count = crc_errors = dropped_total = 0
+  try:
+    for flags, rssi, dropped, ts, payload in records(open_input(args.input, args.baud)):
+      if base is None:
+        base = time.time() - ts / 1000
+      t = base + ts / 1000
+      data = bytes([flags, rssi]) + payload
+      out.write(struct.pack('<IIII', int(t), int((t % 1) * 1e6), len(data), len(data)))
+      out.write(data)
+      out.flush()
+      count += 1
+      crc_errors += flags & 1
+      dropped_total += dropped
+  except KeyboardInterrupt:
+    pass
+  print(f'{count} packets ({crc_errors} CRC errors), {dropped_total} dropped by the device',
+        file=sys.stderr)
+
+
+if __name__ == '__main__':
+  main()